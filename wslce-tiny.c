@@ -159,7 +159,7 @@ static void fd_free(int fd) {
 
 static DWORD map_oflags(DWORD oflags) {
     // map O_* to WinCE access modes (simple subset)
-    // Assume: 0=RDONLY, 1=WRONLY, 2=RDWR, 0x40=O_CREAT, 0x200=O_TRUNC, 0x400=O_APPEND
+    // Assume: 0=RDONLY, 1=WRONLY, 2=RDWR, 0x40=O_CREAT, 0x200=O_TRUNC, 0x80=O_EXCL, 0x400=O_APPEND, 0x1000=O_DSYNC
     DWORD acc = GENERIC_READ;
     if ((oflags & 3) == 1) acc = GENERIC_WRITE;
     else if ((oflags & 3) == 2) acc = GENERIC_READ | GENERIC_WRITE;
@@ -170,7 +170,8 @@ static DWORD map_oflags(DWORD oflags) {
 static DWORD map_creation(DWORD oflags) {
     DWORD disp = OPEN_EXISTING;
     if (oflags & 0x40) { // O_CREAT
-        if (oflags & 0x200) disp = CREATE_ALWAYS; // O_TRUNC
+        if (oflags & 0x80) disp = CREATE_NEW; // O_EXCL
+        else if (oflags & 0x200) disp = CREATE_ALWAYS; // O_TRUNC
         else disp = OPEN_ALWAYS;
     } else if (oflags & 0x200) {
         disp = TRUNCATE_EXISTING;
@@ -187,7 +188,9 @@ static int ce_open(const char* path, int oflags, int mode) {
     DWORD acc = map_oflags(oflags);
     DWORD disp = map_creation(oflags);
     DWORD share = FILE_SHARE_READ | FILE_SHARE_WRITE;
-    HANDLE h = CreateFileW(wpath, acc, share, NULL, disp, FILE_ATTRIBUTE_NORMAL, NULL);
+    DWORD attr = FILE_ATTRIBUTE_NORMAL;
+    if (oflags & 0x1000) attr |= FILE_FLAG_WRITE_THROUGH; // O_DSYNC
+    HANDLE h = CreateFileW(wpath, acc, share, NULL, disp, attr, NULL);
     if (h == INVALID_HANDLE_VALUE) return -1;
 
     int fd = fd_alloc(h);
@@ -223,6 +226,21 @@ static int ce_write(int fd, const void* buf, unsigned len) {
     return (int)put;
 }
 
+static long ce_lseek(int fd, long off, int whence) {
+    HANDLE h = fd_get(fd);
+    if (h == INVALID_HANDLE_VALUE) return -1;
+    // SEEK_SET/CUR/END (0/1/2) match FILE_BEGIN/CURRENT/END
+    DWORD pos = SetFilePointer(h, off, NULL, (DWORD)whence);
+    if (pos == 0xFFFFFFFF && GetLastError() != NO_ERROR) return -1;
+    return (long)pos;
+}
+
+static int ce_fsync(int fd) {
+    HANDLE h = fd_get(fd);
+    if (h == INVALID_HANDLE_VALUE) return -1;
+    return FlushFileBuffers(h) ? 0 : -1;
+}
+
 struct dirent {
     char d_name[260];
     int  d_type; // 4=dir, 8=file (POSIX-ish hints)
@@ -405,6 +423,7 @@ static void bi_help() {
     con_println("  cp <src> <dst>       - copy file");
     con_println("  hexdump <file>       - hex dump");
     con_println("  run <abs-winCE-exe> [args...] - spawn WinCE EXE");
+    con_println("  bench-io [opts] <f>  - dd-like I/O benchmark (-h: opts)");
     con_println("  setroot <\\CE\\path>  - set WinCE root for '/'");
     con_println("  exit                 - quit");
 }
@@ -513,6 +532,226 @@ static void bi_run(int argc, char** argv) {
     if (rc<0) con_println("run: failed");
 }
 
+// -----------------------------
+// bench-io: dd-like benchmark over ce_open/ce_read/ce_write
+// -----------------------------
+#define BENCH_READ        0
+#define BENCH_WRITE       1
+#define BENCH_MIXED       2
+#define BENCH_MAX_BS      (1024UL*1024UL)
+#define BENCH_MAX_SAMPLES 4096 // latency reservoir, keeps the heap small
+
+typedef struct {
+    unsigned long bs, total;
+    int mode, random, wthrough;
+} bench_cfg;
+
+typedef struct {
+    unsigned long ops, bytes, elapsed_us;
+    DWORD p50, p90, p99, max; // per-op latency, us
+} bench_res;
+
+static const char* g_bench_modes[] = { "read", "write", "mixed" };
+static LONGLONG g_bench_freq = 0; // 0 -> GetTickCount fallback
+static DWORD g_bench_rng = 1;
+
+static DWORD bench_rand() {
+    // xorshift32: cheap and good enough to scatter offsets
+    DWORD x = g_bench_rng;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return g_bench_rng = x;
+}
+
+static void bench_timer_init() {
+    LARGE_INTEGER f;
+    g_bench_freq = (QueryPerformanceFrequency(&f) && f.QuadPart > 0) ? f.QuadPart : 0;
+}
+
+static LONGLONG bench_now_us() {
+    if (!g_bench_freq) return (LONGLONG)GetTickCount() * 1000;
+    LARGE_INTEGER c; QueryPerformanceCounter(&c);
+    // split to avoid overflowing the counter * 1e6 product
+    return (c.QuadPart / g_bench_freq) * 1000000
+         + (c.QuadPart % g_bench_freq) * 1000000 / g_bench_freq;
+}
+
+static int bench_cmp_dword(const void* a, const void* b) {
+    DWORD x = *(const DWORD*)a, y = *(const DWORD*)b;
+    return (x > y) - (x < y);
+}
+
+// "4096", "4k", "1m", "1g" -> bytes; 0 on error
+static unsigned long bench_parse_size(const char* s) {
+    unsigned long v = 0;
+    if (!s || *s < '0' || *s > '9') return 0;
+    for (; *s >= '0' && *s <= '9'; ++s) {
+        if (v > 0x7FFFFFFFUL / 10) return 0;
+        v = v * 10 + (unsigned long)(*s - '0');
+    }
+    unsigned long mul = 1;
+    if (*s == 'k' || *s == 'K') mul = 1024UL;
+    else if (*s == 'm' || *s == 'M') mul = 1024UL * 1024UL;
+    else if (*s == 'g' || *s == 'G') mul = 1024UL * 1024UL * 1024UL;
+    else if (*s) return 0;
+    if (mul > 1 && s[1]) return 0;
+    if (v > 0x7FFFFFFFUL / mul) return 0; // ce_lseek offsets are 32-bit signed
+    return v * mul;
+}
+
+// Extend the file from size to total so reads and random ops hit allocated
+// blocks. size < 0 means the file is absent and must be created (O_EXCL, so
+// an existing file is never clobbered here). Runs once, before any timing.
+static int bench_prefill(const char* path, long size, unsigned long total) {
+    if (size >= 0 && (unsigned long)size >= total) return 0;
+    int fd = ce_open(path, size < 0 ? 0xC2/*RDWR|O_CREAT|O_EXCL*/ : 0x02/*RDWR*/, 0644);
+    if (fd < 0) return -1;
+    char* buf = (char*)LocalAlloc(LMEM_FIXED, 65536);
+    int rc = -1;
+    if (!buf) goto out;
+    for (unsigned long i=0; i<65536; ++i) buf[i] = (char)(i * 31 + 7);
+    if (ce_lseek(fd, size < 0 ? 0 : size, 0) < 0) goto out;
+    unsigned long left = total - (unsigned long)(size < 0 ? 0 : size);
+    while (left) {
+        unsigned n = (unsigned)(left < 65536 ? left : 65536);
+        if (ce_write(fd, buf, n) != (int)n) goto out;
+        left -= n;
+    }
+    rc = ce_fsync(fd);
+out:
+    if (buf) LocalFree(buf);
+    ce_close(fd);
+    return rc;
+}
+
+static int bench_run(const char* path, const bench_cfg* cfg, bench_res* r) {
+    unsigned long nops = cfg->total / cfg->bs;
+    if (nops == 0) return -1;
+
+    char* buf = (char*)LocalAlloc(LMEM_FIXED, cfg->bs);
+    DWORD* lat = (DWORD*)LocalAlloc(LMEM_FIXED, BENCH_MAX_SAMPLES * sizeof(DWORD));
+    if (!buf || !lat) { if (buf) LocalFree(buf); if (lat) LocalFree(lat); return -1; }
+    for (unsigned long i=0; i<cfg->bs; ++i) buf[i] = (char)(i * 31 + 7);
+
+    // bench_prefill already sized the file; never create or extend here
+    int oflags = (cfg->mode == BENCH_READ) ? 0/*RDONLY*/ : 0x02/*RDWR*/;
+    if (cfg->wthrough) oflags |= 0x1000; // O_DSYNC
+    int fd = ce_open(path, oflags, 0);
+    int rc = -1;
+    if (fd < 0) goto out;
+
+    ZeroMemory(r, sizeof(*r));
+    unsigned long nsamp = 0;
+    LONGLONG t0 = bench_now_us();
+    for (unsigned long i=0; i<nops; ++i) {
+        int wr = (cfg->mode == BENCH_WRITE) || (cfg->mode == BENCH_MIXED && (bench_rand() & 1));
+        LONGLONG s = bench_now_us();
+        if (cfg->random && ce_lseek(fd, (long)((bench_rand() % nops) * cfg->bs), 0) < 0) goto out;
+        int n = wr ? ce_write(fd, buf, (unsigned)cfg->bs) : ce_read(fd, buf, (unsigned)cfg->bs);
+        if (n != (int)cfg->bs) goto out;
+        LONGLONG d = bench_now_us() - s; // GetTickCount fallback can wrap
+        DWORD us = d > 0 ? (DWORD)d : 0;
+        if (us > r->max) r->max = us;
+        // reservoir sampling keeps percentiles unbiased past BENCH_MAX_SAMPLES ops
+        if (nsamp < BENCH_MAX_SAMPLES) lat[nsamp++] = us;
+        else { DWORD j = bench_rand() % (i + 1); if (j < BENCH_MAX_SAMPLES) lat[j] = us; }
+    }
+    // like dd conv=fsync: count the flush so cached writes don't inflate MB/s
+    if (cfg->mode != BENCH_READ && ce_fsync(fd) < 0) goto out;
+    LONGLONG el = bench_now_us() - t0;
+
+    qsort(lat, nsamp, sizeof(DWORD), bench_cmp_dword);
+    r->ops = nops;
+    r->bytes = nops * cfg->bs;
+    r->elapsed_us = (unsigned long)(el > 0 ? el : 1);
+    r->p50 = lat[(nsamp - 1) * 50 / 100];
+    r->p90 = lat[(nsamp - 1) * 90 / 100];
+    r->p99 = lat[(nsamp - 1) * 99 / 100];
+    rc = 0;
+out:
+    if (fd >= 0) ce_close(fd);
+    LocalFree(lat);
+    LocalFree(buf);
+    return rc;
+}
+
+static void bench_usage() {
+    con_println("bench-io [-b bs] [-s size] [-m read|write|mixed] [-r] [-w] [-S] [-f] <file>");
+    con_println("  -b bs    block size (default 4k; k/m/g suffixes)");
+    con_println("  -s size  total bytes per run (default 1m)");
+    con_println("  -m mode  read, write or mixed 50/50 (default write)");
+    con_println("  -r       random offsets instead of sequential");
+    con_println("  -w       open with FILE_FLAG_WRITE_THROUGH");
+    con_println("  -S       sweep block sizes 512..64k (ignores -b)");
+    con_println("  -f       allow write/mixed runs on an existing file");
+    con_println("Write/mixed runs OVERWRITE the first <size> bytes of an existing");
+    con_println("file and extend it if shorter; without -f they refuse to touch it.");
+    con_println("Read runs never modify an existing file; it must be >= size.");
+    con_println("A missing file is created, filled to size and left in place.");
+}
+
+static void bi_bench_io(int argc, char** argv) {
+    bench_cfg cfg;
+    cfg.bs = 4096; cfg.total = 1024UL * 1024UL;
+    cfg.mode = BENCH_WRITE; cfg.random = 0; cfg.wthrough = 0;
+    int sweep = 0, force = 0;
+    const char* path = NULL;
+
+    for (int i=1; i<argc; ++i) {
+        const char* a = argv[i];
+        if (lstrcmpA(a, "-h")==0) { bench_usage(); return; }
+        else if (lstrcmpA(a, "-r")==0) cfg.random = 1;
+        else if (lstrcmpA(a, "-w")==0) cfg.wthrough = 1;
+        else if (lstrcmpA(a, "-S")==0) sweep = 1;
+        else if (lstrcmpA(a, "-f")==0) force = 1;
+        else if (lstrcmpA(a, "-b")==0 && i+1<argc) cfg.bs = bench_parse_size(argv[++i]);
+        else if (lstrcmpA(a, "-s")==0 && i+1<argc) cfg.total = bench_parse_size(argv[++i]);
+        else if (lstrcmpA(a, "-m")==0 && i+1<argc) {
+            ++i; cfg.mode = -1;
+            for (int m=0; m<3; ++m) if (lstrcmpA(argv[i], g_bench_modes[m])==0) cfg.mode = m;
+            if (cfg.mode < 0) { con_println("bench-io: bad mode: %s", argv[i]); return; }
+        }
+        else if (a[0] != '-' && !path) path = a;
+        else { bench_usage(); return; }
+    }
+    if (!path) { bench_usage(); return; }
+    if (!sweep && (cfg.bs == 0 || cfg.bs > BENCH_MAX_BS)) { con_println("bench-io: bad block size (max 1m)"); return; }
+    if (cfg.total == 0) { con_println("bench-io: bad size"); return; }
+    if (cfg.total < (sweep ? 512 : cfg.bs)) { con_println("bench-io: size smaller than block size"); return; }
+
+    long size = -1; // -1: file does not exist yet
+    int fd = ce_open(path, 0/*RDONLY*/, 0);
+    if (fd >= 0) { size = ce_lseek(fd, 0, 2); ce_close(fd); if (size < 0) size = 0; }
+    if (size >= 0 && cfg.mode != BENCH_READ && !force) {
+        con_println("bench-io: %s exists; -f to overwrite its contents", path); return;
+    }
+    if (size >= 0 && cfg.mode == BENCH_READ && (unsigned long)size < cfg.total) {
+        con_println("bench-io: %s is only %ld bytes; read mode won't extend it", path, size); return;
+    }
+    // prefill once for the whole sweep, outside the timed path
+    if (bench_prefill(path, size, cfg.total) < 0) { con_println("bench-io: cannot prepare %s", path); return; }
+
+    bench_timer_init();
+    g_bench_rng = GetTickCount() | 1;
+    con_println("bench-io: %s %s %lu bytes%s, timer %s", path, cfg.random ? "random" : "seq",
+        cfg.total, cfg.wthrough ? ", write-through" : "", g_bench_freq ? "qpc" : "tick (1ms)");
+    if (cfg.mode != BENCH_WRITE)
+        con_println("bench-io: warning: CE has no uncached reads; read figures may be cache-served (use -s > device RAM)");
+    con_println("%7s %5s %8s %7s %7s %7s %7s %7s", "bs", "mode", "MB/s", "IOPS", "p50us", "p90us", "p99us", "maxus");
+
+    unsigned long lo = sweep ? 512 : cfg.bs, hi = sweep ? 65536 : cfg.bs;
+    for (unsigned long bs = lo; bs <= hi; bs *= 2) {
+        bench_res r;
+        if (bs > cfg.total) break;
+        cfg.bs = bs;
+        if (bench_run(path, &cfg, &r) < 0) { con_println("bench-io: I/O failed at bs=%lu", bs); return; }
+        // MB = 10^6 bytes, as dd reports it; wvsprintf has no %f
+        DWORD mbps100 = (DWORD)((LONGLONG)r.bytes * 100 / r.elapsed_us);
+        DWORD iops = (DWORD)((LONGLONG)r.ops * 1000000 / r.elapsed_us);
+        con_println("%7lu %5s %5lu.%02lu %7lu %7lu %7lu %7lu %7lu", bs, g_bench_modes[cfg.mode],
+            mbps100 / 100, mbps100 % 100, iops, r.p50, r.p90, r.p99, r.max);
+    }
+}
+
 static void bi_setroot(int argc, char** argv) {
     if (argc<2) { con_println("setroot: <\\CE\\path>"); return; }
     lstrcpynA(g_root_utf8, argv[1], sizeof(g_root_utf8));
@@ -543,6 +782,7 @@ static int exec_line(char* line) {
     else if (lstrcmpA(argv[0], "cp")==0) bi_cp(argc, argv);
     else if (lstrcmpA(argv[0], "hexdump")==0) bi_hexdump(argc, argv);
     else if (lstrcmpA(argv[0], "run")==0) bi_run(argc, argv);
+    else if (lstrcmpA(argv[0], "bench-io")==0) bi_bench_io(argc, argv);
     else if (lstrcmpA(argv[0], "setroot")==0) bi_setroot(argc, argv);
     else if (lstrcmpA(argv[0], "exit")==0) return 1;
     else con_println("%s: not found (built-in only)", argv[0]);